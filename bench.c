@@ -0,0 +1,199 @@
+/* Compares the TBL_HASH choices on a few key length distributions, or on
+ * the lines of a file given as the only argument.
+ *
+ *   cc -O2 -march=native -DTBL_HASH_FN bench.c tbl.c -o bench
+ *
+ * For each key set and hash it prints the time tbl_hash() takes per key,
+ * which is the hash as the table runs it with its stored secret, and the
+ * time per tbl_get on a table holding all of them, which also shows the
+ * cost of a weak hash through longer probes. Build tbl.c with the same
+ * engine flags the workload uses. */
+
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tbl.h"
+
+#ifndef TBL_HASH_FN
+#error "build bench.c and tbl.c with -DTBL_HASH_FN"
+#endif
+
+#define NKEYS 200000
+#define ROUNDS 5
+
+struct keyset{
+	const char *name;
+	unsigned int min, max;
+	const char *prefix;
+	int uuid;
+};
+
+/* Lengths roughly as seen in practice: dictionary words, identifiers,
+ * textual UUIDs, URLs, file paths and log lines. */
+static const struct keyset sets[] = {
+	{"words", 2, 14, "", 0},
+	{"idents", 4, 24, "get_", 0},
+	{"uuids", 36, 36, "", 1},
+	{"urls", 30, 120, "https://example.com/", 0},
+	{"paths", 20, 200, "/usr/share/", 0},
+	{"lines", 80, 400, "2024-01-01T00:00:00Z INFO ", 0},
+};
+
+static const struct{
+	const char *name;
+	tbl_hash_fn fn;
+} hashes[] = {
+	{"xxh3", tbl_hash_xxh3},
+	{"xxh3_128", tbl_hash_xxh3_128},
+	{"wy", tbl_hash_wy},
+	{"crc32c", tbl_hash_crc32c},
+};
+
+static char **keys;
+static size_t *lens;
+static size_t nkeys;
+static volatile unsigned long long sink;
+
+static unsigned long long _rng = 0x9e3779b97f4a7c15ull;
+
+static unsigned long long _rand(void)
+{
+	_rng ^= _rng << 13;
+	_rng ^= _rng >> 7;
+	_rng ^= _rng << 17;
+	return _rng;
+}
+
+static double _now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int _add(const char *s, size_t len)
+{
+	char *k = malloc(len + 1);
+	if (!k)
+		return -1;
+	memcpy(k, s, len);
+	k[len] = '\0';
+	keys[nkeys] = k;
+	lens[nkeys++] = len;
+	return 0;
+}
+
+/* Keys are unique by a running number in front of random characters. Short
+ * sets skew towards their minimum like natural language does. */
+static int _generate(const struct keyset *ks)
+{
+	static const char chars[] = "abcdefghijklmnopqrstuvwxyz0123456789-_/";
+	char buf[512];
+	size_t i, j;
+
+	for (i = 0; i < NKEYS; i++){
+		size_t span = ks->max - ks->min + 1;
+		size_t len = ks->min + (ks->max <= 16 ? _rand() % span * (_rand() % span) / span : _rand() % span);
+		size_t n = (size_t)snprintf(buf, sizeof(buf), "%s%zx", ks->prefix, i);
+		if (ks->uuid)
+			n = (size_t)snprintf(buf, sizeof(buf), "%08zx-%04llx-4%03llx-a%03llx-%012llx", i,
+					_rand() & 0xffff, _rand() & 0xfff, _rand() & 0xfff, _rand() & 0xffffffffffffull);
+		for (j = n; j < len; j++)
+			buf[j] = chars[_rand() % (sizeof(chars) - 1)];
+		if (_add(buf, len > n ? len : n))
+			return -1;
+	}
+	return 0;
+}
+
+static int _load(const char *path)
+{
+	char buf[4096];
+	FILE *f = fopen(path, "r");
+
+	if (!f)
+		return -1;
+	while (nkeys < NKEYS && fgets(buf, sizeof(buf), f)){
+		size_t len = strcspn(buf, "\r\n");
+		if (len && _add(buf, len)){
+			fclose(f);
+			return -1;
+		}
+	}
+	fclose(f);
+	return 0;
+}
+
+static void _clear(void)
+{
+	while (nkeys)
+		free(keys[--nkeys]);
+	return;
+}
+
+static void _run(const char *name)
+{
+	size_t i, total = 0;
+
+	for (i = 0; i < nkeys; i++)
+		total += lens[i];
+	for (size_t h = 0; h < sizeof(hashes) / sizeof(hashes[0]); h++){
+		struct tbl *t = tbl_create();
+		double hash_ns = 1e300, get_ns = 1e300;
+		unsigned long long acc = 0;
+
+		if (!t || tbl_set_hash(t, hashes[h].fn))
+			exit(1);
+		for (i = 0; i < nkeys; i++){
+			if (tbl_put_n(t, keys[i], lens[i]))
+				exit(1);
+		}
+		for (int r = 0; r < ROUNDS; r++){
+			double start = _now();
+			for (i = 0; i < nkeys; i++)
+				acc += tbl_hash(t, keys[i], lens[i]);
+			double mid = _now();
+			for (i = 0; i < nkeys; i++)
+				acc += tbl_get_n(t, keys[i], lens[i]) != NULL;
+			double end = _now();
+			if (mid - start < hash_ns)
+				hash_ns = mid - start;
+			if (end - mid < get_ns)
+				get_ns = end - mid;
+		}
+		sink = acc;
+		printf("%-8s %6.1f %-9s %8.2f %7.2f %8.2f\n", name, (double)total / nkeys,
+				hashes[h].name, hash_ns / nkeys, total / hash_ns, get_ns / nkeys);
+		tbl_free(t);
+	}
+	return;
+}
+
+int main(int argc, char **argv)
+{
+	keys = malloc(NKEYS * sizeof(*keys));
+	lens = malloc(NKEYS * sizeof(*lens));
+	if (!keys || !lens)
+		return 1;
+	printf("%-8s %6s %-9s %8s %7s %8s\n", "keys", "avglen", "hash", "ns/key", "GB/s", "ns/get");
+	if (argc > 1){
+		if (_load(argv[1])){
+			perror(argv[1]);
+			return 1;
+		}
+		_run(argv[1]);
+		_clear();
+	}else{
+		for (size_t s = 0; s < sizeof(sets) / sizeof(sets[0]); s++){
+			if (_generate(&sets[s]))
+				return 1;
+			_run(sets[s].name);
+			_clear();
+		}
+	}
+	free(keys);
+	free(lens);
+	return 0;
+}
@@ -24,159 +24,1397 @@
 #include <assert.h>
 #include "tbl.h"
 
+#if defined(TBL_DISPATCH) && !defined(TBL_KEY_RAW_HASH) && !defined(TBL_HASH_FN) && TBL_HASH == TBL_HASH_XXH3 \
+	&& defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define HASH_DISPATCH 1
+#define XXH_X86DISPATCH 1
+#define XXH_DISPATCH_AVX2 1
+#define XXH_DISPATCH_AVX512 1
+#define XXH_TARGET_SSE2 __attribute__((__target__("sse2")))
+#define XXH_TARGET_AVX2 __attribute__((__target__("avx2")))
+#define XXH_TARGET_AVX512 __attribute__((__target__("avx512f")))
+#include <immintrin.h>
+#endif
+
 #define XXH_INLINE_ALL 1
 #define XXH_NO_STREAM 1
 #include "xxhash.h"
 
+#if (defined(TBL_SWISS) || defined(TBL_KEY_WIDTH)) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if (defined(TBL_SOA) || defined(TBL_KEY_WIDTH)) && defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#ifdef __SSE4_2__
+#include <nmmintrin.h>
+#endif
+
+#ifdef TBL_KEY_WIDTH
+#define _keylen(key) ((void)(key), (size_t)TBL_KEY_WIDTH)
+#else
+#define _keylen(key) strlen(key)
+#endif
+
+#if XXH3_SECRET_DEFAULT_SIZE != TBL_SECRET_SIZE
+#error "TBL_SECRET_SIZE does not match XXH3_SECRET_DEFAULT_SIZE"
+#endif
+
+#define MIGRATE_ALL ((tbl_size_t)-1)
+#define BATCH 16
+
+#if TBL_HASH == TBL_HASH_XXH3_128
+#define DEFAULT_HASH tbl_hash_xxh3_128
+#elif TBL_HASH == TBL_HASH_WY
+#define DEFAULT_HASH tbl_hash_wy
+#elif TBL_HASH == TBL_HASH_CRC32C
+#define DEFAULT_HASH tbl_hash_crc32c
+#else
+#define DEFAULT_HASH tbl_hash_xxh3
+#endif
+
+static const struct tbl_policy _default_policy = {TBL_MAX_LOAD, TBL_MIN_LOAD, TBL_GROW_LG2};
+
+static inline void _bounds(struct tbl *t)
+{
+	t->grow_at = _tbl_limit(t->policy.max_load, t->max);
+	t->shrink_at = _tbl_limit(t->policy.min_load, t->max);
+	return;
+}
+
 static inline void _init(struct tbl *t, struct tbl_bkt *array, unsigned int n_lg2)
 {
 	assert(t && array && n_lg2);
-	if (t->n)
-		memset(array, 0, sizeof(struct tbl_bkt) << n_lg2);
 	t->seed = (unsigned long)t;
 	t->a = array;
 	t->n = 0;
-	t->max = 1 << n_lg2;
+	t->max = (tbl_size_t)1 << n_lg2;
 	t->max_lg2 = n_lg2;
-	t->hashmask = ~(ULONG_MAX << n_lg2);
+	t->hashmask = t->max - 1;
+	_bounds(t);
+#ifdef TBL_SWISS
+	t->ctrl = (unsigned char *)(array + ((size_t)1 << n_lg2));
+#endif
+#ifdef TBL_SOA
+	t->hash = (tbl_hash_t *)(array + ((size_t)1 << n_lg2));
+	t->maxoff = (unsigned int *)(t->hash + ((size_t)1 << n_lg2));
+#endif
 	return;
 }
 
-static inline int _put(struct tbl *t, void *value)
+static inline struct tbl_bkt *_alloc(unsigned int n_lg2)
 {
-	assert(t && value);
-	unsigned int hash = (unsigned int)XXH3_64bits_withSeed((char*)value, strlen((char*)value), t->seed);
-	unsigned int pos = hash & t->hashmask;
+#if defined(TBL_SWISS)
+	size_t size = sizeof(struct tbl_bkt) + 1;
+#elif defined(TBL_SOA)
+	size_t size = sizeof(struct tbl_bkt) + sizeof(tbl_hash_t) + sizeof(unsigned int);
+#else
+	size_t size = sizeof(struct tbl_bkt);
+#endif
+	/* TBL_WIDE allows n_lg2 up to 63, past what size_t bytes can hold */
+	if (size > SIZE_MAX >> n_lg2)
+		return NULL;
+#if defined(TBL_CUCKOO) && __STDC_VERSION__ >= 201112L
+	struct tbl_bkt *array = aligned_alloc(64, size << n_lg2);
+	if (array)
+		memset(array, 0, size << n_lg2);
+	return array;
+#else
+	return calloc(1, size << n_lg2);
+#endif
+}
+
+static inline tbl_hash_t _hashat(struct tbl *t, tbl_size_t pos)
+{
+#ifdef TBL_SOA
+	return t->hash[pos];
+#else
+	return t->a[pos].hash;
+#endif
+}
+
+static inline unsigned int _ctz(unsigned int m)
+{
+#ifdef __GNUC__
+	return __builtin_ctz(m);
+#else
+	unsigned int i = 0;
+	while (!(m & 1)){
+		m >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+static inline int _badlen(size_t keylen)
+{
+#ifdef TBL_KEY_WIDTH
+	return keylen != TBL_KEY_WIDTH;
+#else
+	return keylen > UINT_MAX;
+#endif
+}
+
+#ifdef HASH_DISPATCH
+/* Long key XXH3 loop built once per x86 kernel. All of them return the
+ * same values as the compiled default. */
+typedef XXH64_hash_t (*_hash_long_f)(const void *key, size_t len, const void *secret);
+
+static XXH_TARGET_SSE2 XXH64_hash_t _hash_long_sse2(const void *key, size_t len, const void *secret)
+{
+	return XXH3_hashLong_64b_internal(key, len, secret, TBL_SECRET_SIZE, XXH3_accumulate_sse2, XXH3_scrambleAcc_sse2);
+}
+
+static XXH_TARGET_AVX2 XXH64_hash_t _hash_long_avx2(const void *key, size_t len, const void *secret)
+{
+	return XXH3_hashLong_64b_internal(key, len, secret, TBL_SECRET_SIZE, XXH3_accumulate_avx2, XXH3_scrambleAcc_avx2);
+}
+
+static XXH_TARGET_AVX512 XXH64_hash_t _hash_long_avx512(const void *key, size_t len, const void *secret)
+{
+	return XXH3_hashLong_64b_internal(key, len, secret, TBL_SECRET_SIZE, XXH3_accumulate_avx512, XXH3_scrambleAcc_avx512);
+}
+
+static XXH64_hash_t _hash_long_default(const void *key, size_t len, const void *secret)
+{
+	return XXH3_hashLong_64b_internal(key, len, secret, TBL_SECRET_SIZE, XXH3_accumulate, XXH3_scrambleAcc);
+}
+
+static XXH64_hash_t _hash_long_pick(const void *key, size_t len, const void *secret);
+static _hash_long_f _hash_long = _hash_long_pick;
+
+/* Picks the widest kernel the host runs on first use. Threads racing
+ * here all store the same pointer. */
+static XXH64_hash_t _hash_long_pick(const void *key, size_t len, const void *secret)
+{
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		_hash_long = _hash_long_avx512;
+	else if (__builtin_cpu_supports("avx2"))
+		_hash_long = _hash_long_avx2;
+	else if (__builtin_cpu_supports("sse2"))
+		_hash_long = _hash_long_sse2;
+	else
+		_hash_long = _hash_long_default;
+	return _hash_long(key, len, secret);
+}
+#endif
+
+/* wyhash final version 4 default secret */
+#define WYP0 0x2d358dccaa6c78a5ull
+#define WYP1 0x8bb84b93962eacc9ull
+#define WYP2 0x4b33a62ed433d4a3ull
+#define WYP3 0x4d5a2da51de1aa47ull
+
+/* Follows wyhash: 128-bit multiplies folded to 64 bits, three lanes for
+ * long keys and overlapping reads for the tail. */
+static inline uint64_t _hash_wy(const void *key, size_t len, uint64_t seed)
+{
+	const xxh_u8 *p = (const xxh_u8 *)key;
+	XXH128_hash_t m;
+	uint64_t a, b;
+
+	seed ^= XXH3_mul128_fold64(seed ^ WYP0, WYP1);
+	if (len <= 16){
+		if (len >= 4){
+			size_t d = (len >> 3) << 2;
+			a = (uint64_t)XXH_readLE32(p) << 32 | XXH_readLE32(p + d);
+			b = (uint64_t)XXH_readLE32(p + len - 4) << 32 | XXH_readLE32(p + len - 4 - d);
+		}else if (len){
+			a = (uint64_t)p[0] << 16 | (uint64_t)p[len >> 1] << 8 | p[len - 1];
+			b = 0;
+		}else{
+			a = b = 0;
+		}
+	}else{
+		size_t i = len;
+		if (i > 48){
+			uint64_t s1 = seed, s2 = seed;
+			do{
+				seed = XXH3_mul128_fold64(XXH_readLE64(p) ^ WYP1, XXH_readLE64(p + 8) ^ seed);
+				s1 = XXH3_mul128_fold64(XXH_readLE64(p + 16) ^ WYP2, XXH_readLE64(p + 24) ^ s1);
+				s2 = XXH3_mul128_fold64(XXH_readLE64(p + 32) ^ WYP3, XXH_readLE64(p + 40) ^ s2);
+				p += 48;
+				i -= 48;
+			}while (i > 48);
+			seed ^= s1 ^ s2;
+		}
+		while (i > 16){
+			seed = XXH3_mul128_fold64(XXH_readLE64(p) ^ WYP1, XXH_readLE64(p + 8) ^ seed);
+			p += 16;
+			i -= 16;
+		}
+		a = XXH_readLE64(p + i - 16);
+		b = XXH_readLE64(p + i - 8);
+	}
+	m = XXH_mult64to128(a ^ WYP1, b ^ seed);
+	return XXH3_mul128_fold64(m.low64 ^ WYP0 ^ len, m.high64 ^ WYP1);
+}
+
+static inline uint64_t _crc32c(uint64_t crc, uint64_t v)
+{
+#if defined(__SSE4_2__) && defined(__x86_64__)
+	return _mm_crc32_u64(crc, v);
+#elif defined(__SSE4_2__)
+	return _mm_crc32_u32(_mm_crc32_u32((uint32_t)crc, (uint32_t)v), (uint32_t)(v >> 32));
+#else
+	uint32_t c = (uint32_t)crc;
+	for (unsigned int i=0; i != 64; i++){
+		c ^= (uint32_t)(v >> i) & 1;
+		c = c >> 1 ^ (0x82f63b78u & -(c & 1));
+	}
+	return c;
+#endif
+}
+
+/* Two CRC32C lanes of 8 bytes each, tails read overlapping as in XXH3.
+ * CRC is linear, so the lanes are joined by the XXH3 avalanche. */
+static inline uint64_t _hash_crc32c(const void *key, size_t len, uint64_t seed)
+{
+	const xxh_u8 *p = (const xxh_u8 *)key;
+	uint64_t a = (uint32_t)seed, b = (seed >> 32) ^ len;
+
+	if (len > 16){
+		size_t i = len;
+		for (; i > 16; i -= 16, p += 16){
+			a = _crc32c(a, XXH_readLE64(p));
+			b = _crc32c(b, XXH_readLE64(p + 8));
+		}
+		a = _crc32c(a, XXH_readLE64(p + i - 16));
+		b = _crc32c(b, XXH_readLE64(p + i - 8));
+	}else if (len >= 8){
+		a = _crc32c(a, XXH_readLE64(p));
+		b = _crc32c(b, XXH_readLE64(p + len - 8));
+	}else if (len >= 4){
+		a = _crc32c(a, (uint64_t)XXH_readLE32(p) << 32 | XXH_readLE32(p + len - 4));
+	}else if (len){
+		a = _crc32c(a, (uint64_t)p[0] << 16 | (uint64_t)p[len >> 1] << 8 | p[len - 1]);
+	}
+	return XXH3_avalanche(a << 32 | b);
+}
+
+#ifdef TBL_HAS_SECRET
+static inline uint64_t _hash_xxh3_128(struct tbl *t, const char *key, size_t keylen)
+{
+	XXH128_hash_t h = XXH3_128bits_withSecretandSeed(key, keylen, t->secret, TBL_SECRET_SIZE, t->seed);
+	return h.low64 ^ h.high64;
+}
+#endif
+
+static inline tbl_hash_t _hash(struct tbl *t, const char *key, size_t keylen)
+{
+#if defined(TBL_KEY_RAW_HASH)
+	tbl_hash_t hash;
+	(void)t;
+	(void)keylen;
+	memcpy(&hash, key, sizeof(hash));
+	return hash;
+#elif defined(TBL_HASH_FN)
+	/* the built-in XXH3 hashes would derive a secret per call for long keys */
+	if (keylen > XXH3_MIDSIZE_MAX && t->hashfn == tbl_hash_xxh3)
+		return (tbl_hash_t)XXH3_64bits_withSecretandSeed(key, keylen, t->secret, TBL_SECRET_SIZE, t->seed);
+	if (keylen > XXH3_MIDSIZE_MAX && t->hashfn == tbl_hash_xxh3_128)
+		return (tbl_hash_t)_hash_xxh3_128(t, key, keylen);
+	return (tbl_hash_t)t->hashfn(key, keylen, t->seed);
+#elif TBL_HASH == TBL_HASH_XXH3_128
+	return (tbl_hash_t)_hash_xxh3_128(t, key, keylen);
+#elif TBL_HASH == TBL_HASH_WY
+	return (tbl_hash_t)_hash_wy(key, keylen, t->seed);
+#elif TBL_HASH == TBL_HASH_CRC32C
+	return (tbl_hash_t)_hash_crc32c(key, keylen, t->seed);
+#else
+#ifdef HASH_DISPATCH
+	if (keylen > XXH3_MIDSIZE_MAX)
+		return (tbl_hash_t)_hash_long(key, keylen, t->secret);
+#endif
+	return (tbl_hash_t)XXH3_64bits_withSecretandSeed(key, keylen, t->secret, TBL_SECRET_SIZE, t->seed);
+#endif
+}
+
+static inline int _eq(struct tbl_bkt *b, const char *key, size_t keylen)
+{
+#if defined(TBL_KEY_WIDTH) && TBL_KEY_WIDTH == 32 && defined(__AVX2__)
+	__m256i x = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)key),
+			_mm256_loadu_si256((const __m256i *)b->key));
+	(void)keylen;
+	return b->value && _mm256_movemask_epi8(x) == -1;
+#elif defined(TBL_KEY_WIDTH) && defined(__SSE2__)
+	__m128i x = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)key),
+			_mm_loadu_si128((const __m128i *)b->key));
+#if TBL_KEY_WIDTH == 32
+	x = _mm_and_si128(x, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(key + 16)),
+			_mm_loadu_si128((const __m128i *)(b->key + 16))));
+#endif
+	(void)keylen;
+	return b->value && _mm_movemask_epi8(x) == 0xffff;
+#elif defined(TBL_KEY_WIDTH)
+	(void)keylen;
+	return b->value && !(memcmp(key, b->key, TBL_KEY_WIDTH));
+#else
+#ifdef TBL_INLINE_KEY
+	if (keylen <= TBL_INLINE_KEY)
+		return keylen == b->len && b->value && !(memcmp(key, b->key, keylen));
+#endif
+	return keylen == b->len && b->value && !(memcmp(key, b->value, keylen));
+#endif
+}
+
+static inline void _entry(struct tbl_bkt *e, const char *key, size_t keylen)
+{
+	e->value = (void *)key;
+	e->len = keylen;
+#ifdef TBL_INLINE_KEY
+	if (keylen <= TBL_INLINE_KEY)
+		memcpy(e->key, key, keylen);
+#endif
+	return;
+}
+
+static inline void _set(struct tbl *t, tbl_size_t pos, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	t->a[pos].value = e->value;
+	t->a[pos].len = e->len;
+#ifdef TBL_MAP
+	t->a[pos].data = e->data;
+#endif
+#ifdef TBL_INLINE_KEY
+	memcpy(t->a[pos].key, e->key, TBL_INLINE_KEY);
+#endif
+#ifdef TBL_SOA
+	t->hash[pos] = hash;
+#else
+	t->a[pos].hash = hash;
+#endif
+	return;
+}
+
+#if defined(TBL_SWISS)
+#define CTRL_EMPTY 0x00
+#define CTRL_DELETED 0x01
+
+static inline unsigned char _tag(tbl_hash_t hash)
+{
+	return 0x80 | (hash >> (sizeof(tbl_hash_t) * CHAR_BIT - 7));
+}
+
+static inline unsigned int _match(const unsigned char *g, unsigned char c)
+{
+#ifdef __SSE2__
+	__m128i v = _mm_load_si128((const __m128i *)g);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8((char)c)));
+#else
+	unsigned int m = 0;
+	for (unsigned int i=0; i != TBL_GROUP; i++){
+		if (g[i] == c)
+			m |= 1u << i;
+	}
+	return m;
+#endif
+}
+
+static inline unsigned int _match_free(const unsigned char *g)
+{
+#ifdef __SSE2__
+	return ~_mm_movemask_epi8(_mm_load_si128((const __m128i *)g)) & 0xffff;
+#else
+	unsigned int m = 0;
+	for (unsigned int i=0; i != TBL_GROUP; i++){
+		if (!(g[i] & 0x80))
+			m |= 1u << i;
+	}
+	return m;
+#endif
+}
+
+static inline int _place(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	tbl_size_t g = hash & t->hashmask & ~(tbl_size_t)(TBL_GROUP - 1);
+	unsigned int m;
+	tbl_size_t pos;
+	while (!(m = _match_free(t->ctrl + g)))
+		g = (g + TBL_GROUP) & t->hashmask;
+	pos = g + _ctz(m);
+	if (t->ctrl[pos] == CTRL_DELETED)
+		t->dead--;
+	t->ctrl[pos] = _tag(hash);
+	_set(t, pos, e, hash);
+	t->n++;
+	return 0;
+}
+
+static inline struct tbl_bkt *_find(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	unsigned char tag = _tag(hash);
+	tbl_size_t g = hash & t->hashmask & ~(tbl_size_t)(TBL_GROUP - 1);
+
+	for (tbl_size_t i=t->max / TBL_GROUP; i; i--){
+		unsigned int m = _match(t->ctrl + g, tag);
+		while (m){
+			tbl_size_t pos = g + _ctz(m);
+			if (hash == t->a[pos].hash && _eq(&t->a[pos], key, keylen))
+				return &t->a[pos];
+			m &= m - 1;
+		}
+		if (_match(t->ctrl + g, CTRL_EMPTY))
+			return NULL;
+		g = (g + TBL_GROUP) & t->hashmask;
+	}
+	return NULL;
+}
+
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
+{
+	tbl_size_t pos = b - t->a;
+	if (_match(t->ctrl + (pos & ~(tbl_size_t)(TBL_GROUP - 1)), CTRL_EMPTY)){
+		t->ctrl[pos] = CTRL_EMPTY;
+	}else{
+		t->ctrl[pos] = CTRL_DELETED;
+		t->dead++;
+	}
+	b->value = NULL;
+	t->n--;
+	return;
+}
+#elif defined(TBL_SOA)
+static inline int _place(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	tbl_size_t home = hash & t->hashmask;
+	tbl_size_t pos = home;
 	unsigned int off = 0;
-	if (t->n == t->max)
-		return -1;
-	while (1){
-		if (!t->a[pos].value)
-			break;
+	while (t->a[pos].value){
 		pos = (pos+1) & t->hashmask;
 		++off;
 	}
-	t->a[pos].value = value;
-	t->a[pos].hash = hash;
-	if (off > t->a[pos].maxoff)
-		t->a[pos].maxoff = off;
+	_set(t, pos, e, hash);
+	if (off > t->maxoff[home])
+		t->maxoff[home] = off;
 	t->n++;
 	return 0;
 }
 
-static inline void *_get(struct tbl *t, const char *key)
+static inline unsigned int _scan(struct tbl *t, tbl_size_t pos, tbl_hash_t hash)
 {
-	assert(t && key);
-	size_t keylen = strlen(key);
-	unsigned int hash = (unsigned int)XXH3_64bits_withSeed(key, keylen, t->seed);
-	unsigned int pos = hash & t->hashmask;
-
-	for (unsigned int off=t->a[pos].maxoff; off >= 0; off--){
-		if (t->a[pos].value && hash == t->a[pos].hash){
-			if (!(memcmp(key, t->a[pos].value, keylen)))
-				return t->a[pos].value;
+	unsigned int m = 0;
+#if defined(__AVX2__) && defined(TBL_WIDE)
+	if (pos + 8 <= t->max){
+		__m256i h = _mm256_set1_epi64x((long long)hash);
+		__m256i lo = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(t->hash + pos)), h);
+		__m256i hi = _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(t->hash + pos + 4)), h);
+		return _mm256_movemask_pd(_mm256_castsi256_pd(lo)) | _mm256_movemask_pd(_mm256_castsi256_pd(hi)) << 4;
+	}
+#elif defined(__AVX2__)
+	if (pos + 8 <= t->max){
+		__m256i v = _mm256_loadu_si256((const __m256i *)(t->hash + pos));
+		v = _mm256_cmpeq_epi32(v, _mm256_set1_epi32((int)hash));
+		return _mm256_movemask_ps(_mm256_castsi256_ps(v));
+	}
+#endif
+	for (unsigned int i=0; i != 8; i++){
+		if (t->hash[(pos + i) & t->hashmask] == hash)
+			m |= 1u << i;
+	}
+	return m;
+}
+
+static inline struct tbl_bkt *_find(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	tbl_size_t pos = hash & t->hashmask;
+	unsigned int left = t->maxoff[pos] + 1;
+
+	while (left){
+		unsigned int w = left < 8 ? left : 8;
+		unsigned int m = _scan(t, pos, hash) & ((1u << w) - 1);
+		while (m){
+			struct tbl_bkt *b = &t->a[(pos + _ctz(m)) & t->hashmask];
+			if (_eq(b, key, keylen))
+				return b;
+			m &= m - 1;
 		}
-		pos = (pos+1) & t->hashmask;
+		pos = (pos + w) & t->hashmask;
+		left -= w;
 	}
 	return NULL;
 }
 
-static inline void *_remove(struct tbl *t, const char *key)
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
 {
-	assert(t && key);
-	size_t keylen = strlen(key);
-	unsigned int hash = (unsigned int)XXH3_64bits_withSeed(key, keylen, t->seed);
-	unsigned int pos = hash & t->hashmask;
-	void *found;
+	b->value = NULL;
+	t->n--;
+	return;
+}
+#elif defined(TBL_CUCKOO)
+static inline tbl_size_t _bkt1(struct tbl *t, tbl_hash_t hash)
+{
+	return hash & (t->hashmask / TBL_SLOTS);
+}
+
+static inline tbl_size_t _bkt2(struct tbl *t, tbl_hash_t hash)
+{
+#ifdef TBL_WIDE
+	return ((hash >> 32 | hash << 32) * 0x9e3779b97f4a7c15u) & (t->hashmask / TBL_SLOTS);
+#else
+	return ((hash >> 16 | hash << 16) * 0x9e3779b1u) & (t->hashmask / TBL_SLOTS);
+#endif
+}
+
+static inline tbl_size_t _vacant(struct tbl *t, tbl_size_t bkt)
+{
+	for (tbl_size_t pos=bkt * TBL_SLOTS; pos != (bkt+1) * TBL_SLOTS; pos++){
+		if (!t->a[pos].value)
+			return pos;
+	}
+	return t->max;
+}
+
+static inline int _place(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	tbl_size_t path[TBL_CUCKOO_KICKS];
+	struct tbl_bkt tmp = *e;
+	tbl_size_t bkt = _bkt1(t, hash);
+	tbl_size_t pos = _vacant(t, bkt);
+	unsigned int rnd = (unsigned int)hash | 1;
+	unsigned int depth = 0;
 
-	for (unsigned int off=t->a[pos].maxoff; off >= 0; off--){
-		if (t->a[pos].value && hash == t->a[pos].hash){
-			if (!(memcmp(key, t->a[pos].value, keylen))){
-				found = t->a[pos].value;
-				t->a[pos].value = NULL;
-				t->n--;
-				return found;
+	tmp.hash = hash;
+	if (pos == t->max)
+		pos = _vacant(t, _bkt2(t, hash));
+	while (pos == t->max){
+		struct tbl_bkt swap;
+		if (depth == TBL_CUCKOO_KICKS){
+			while (depth--){
+				swap = t->a[path[depth]];
+				t->a[path[depth]] = tmp;
+				tmp = swap;
 			}
+			return -1;
+		}
+		rnd ^= rnd << 13;
+		rnd ^= rnd >> 17;
+		rnd ^= rnd << 5;
+		pos = bkt * TBL_SLOTS + (rnd & (TBL_SLOTS - 1));
+		path[depth++] = pos;
+		swap = t->a[pos];
+		t->a[pos] = tmp;
+		tmp = swap;
+		bkt = _bkt1(t, tmp.hash);
+		if (bkt == pos / TBL_SLOTS)
+			bkt = _bkt2(t, tmp.hash);
+		pos = _vacant(t, bkt);
+	}
+	t->a[pos] = tmp;
+	t->n++;
+	return 0;
+}
+
+static inline struct tbl_bkt *_find(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	tbl_size_t bkt[2] = {_bkt1(t, hash), _bkt2(t, hash)};
+
+	for (unsigned int i=0; i != 2; i++){
+		struct tbl_bkt *b = &t->a[bkt[i] * TBL_SLOTS];
+		for (unsigned int j=0; j != TBL_SLOTS; j++){
+			if (hash == b[j].hash && _eq(&b[j], key, keylen))
+				return &b[j];
 		}
+	}
+	return NULL;
+}
+
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
+{
+	b->value = NULL;
+	t->n--;
+	return;
+}
+#elif defined(TBL_HOPSCOTCH)
+#define HOP_SCAN (TBL_HOP * 8)
+
+static inline int _place(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	tbl_size_t home = hash & t->hashmask;
+	tbl_size_t pos = home;
+	unsigned int off = 0;
+	while (t->a[pos].value){
+		if (++off == HOP_SCAN)
+			return -1;
+		pos = (pos+1) & t->hashmask;
+	}
+	while (off >= TBL_HOP){
+		unsigned int dist, m = 0;
+		tbl_size_t from, c = pos;
+		for (dist=TBL_HOP - 1; dist; dist--){
+			c = (pos - dist) & t->hashmask;
+			if ((m = t->a[c].hop & ((1u << dist) - 1)))
+				break;
+		}
+		if (!m)
+			return -1;
+		from = (c + _ctz(m)) & t->hashmask;
+		_set(t, pos, &t->a[from], t->a[from].hash);
+		t->a[from].value = NULL;
+		t->a[c].hop ^= (m & -m) | (1u << dist);
+		off -= (pos - from) & t->hashmask;
+		pos = from;
+	}
+	_set(t, pos, e, hash);
+	t->a[home].hop |= 1u << off;
+	t->n++;
+	return 0;
+}
+
+static inline struct tbl_bkt *_find(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	tbl_size_t home = hash & t->hashmask;
+
+	for (unsigned int m=t->a[home].hop; m; m &= m - 1){
+		tbl_size_t pos = (home + _ctz(m)) & t->hashmask;
+		if (hash == t->a[pos].hash && _eq(&t->a[pos], key, keylen))
+			return &t->a[pos];
+	}
+	return NULL;
+}
+
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
+{
+	tbl_size_t pos = b - t->a;
+	tbl_size_t home = b->hash & t->hashmask;
+	t->a[home].hop &= ~(1u << ((pos - home) & t->hashmask));
+	b->value = NULL;
+	t->n--;
+	return;
+}
+#elif defined(TBL_ROBIN_HOOD)
+static inline tbl_size_t _dist(struct tbl *t, tbl_size_t pos)
+{
+	return (pos - t->a[pos].hash) & t->hashmask;
+}
+
+static inline int _place(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	tbl_size_t pos = hash & t->hashmask;
+	tbl_size_t off = 0;
+	struct tbl_bkt tmp = *e;
+	tmp.hash = hash;
+	while (t->a[pos].value){
+		tbl_size_t d = _dist(t, pos);
+		if (d < off){
+			struct tbl_bkt swap = t->a[pos];
+			t->a[pos] = tmp;
+			tmp = swap;
+			off = d;
+		}
+		pos = (pos+1) & t->hashmask;
+		++off;
+	}
+	t->a[pos] = tmp;
+	t->n++;
+	return 0;
+}
+
+static inline struct tbl_bkt *_find(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	tbl_size_t pos = hash & t->hashmask;
+
+	for (tbl_size_t off=0; t->a[pos].value && _dist(t, pos) >= off; off++){
+		if (hash == t->a[pos].hash && _eq(&t->a[pos], key, keylen))
+			return &t->a[pos];
+		pos = (pos+1) & t->hashmask;
+	}
+	return NULL;
+}
+
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
+{
+	tbl_size_t pos = b - t->a;
+	tbl_size_t next = (pos+1) & t->hashmask;
+	while (t->a[next].value && _dist(t, next)){
+		t->a[pos] = t->a[next];
+		pos = next;
+		next = (next+1) & t->hashmask;
+	}
+	t->a[pos].value = NULL;
+	t->n--;
+	return;
+}
+#else
+static inline int _place(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	tbl_size_t home = hash & t->hashmask;
+	tbl_size_t pos = home;
+	unsigned int off = 0;
+	while (t->a[pos].value){
+		pos = (pos+1) & t->hashmask;
+		++off;
+	}
+	_set(t, pos, e, hash);
+	if (off > t->a[home].maxoff)
+		t->a[home].maxoff = off;
+	t->n++;
+	return 0;
+}
+
+static inline struct tbl_bkt *_find(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	tbl_size_t pos = hash & t->hashmask;
+
+	for (unsigned int off=t->a[pos].maxoff + 1; off; off--){
+		if (hash == t->a[pos].hash && _eq(&t->a[pos], key, keylen))
+			return &t->a[pos];
 		pos = (pos+1) & t->hashmask;
 	}
 	return NULL;
 }
 
-static inline void _copy(struct tbl *dest, struct tbl *src)
+#ifdef TBL_BACKWARD_SHIFT
+static inline void _trim(struct tbl *t, tbl_size_t home)
+{
+	tbl_size_t pos = home;
+	unsigned int maxoff = 0;
+	for (unsigned int off=0; off <= t->a[home].maxoff; off++){
+		if (t->a[pos].value && (t->a[pos].hash & t->hashmask) == home)
+			maxoff = off;
+		pos = (pos+1) & t->hashmask;
+	}
+	t->a[home].maxoff = maxoff;
+	return;
+}
+
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
+{
+	tbl_size_t hole = b - t->a;
+	tbl_size_t pos = hole;
+	tbl_size_t home = b->hash & t->hashmask;
+	b->value = NULL;
+	t->n--;
+	_trim(t, home);
+	while (1){
+		pos = (pos+1) & t->hashmask;
+		if (!t->a[pos].value)
+			break;
+		home = t->a[pos].hash & t->hashmask;
+		if (!_tbl_shift(home, hole, pos, t->hashmask))
+			continue;
+		_set(t, hole, &t->a[pos], t->a[pos].hash);
+		t->a[pos].value = NULL;
+		hole = pos;
+		_trim(t, home);
+	}
+	return;
+}
+#else
+static inline void _erase(struct tbl *t, struct tbl_bkt *b)
+{
+	b->value = NULL;
+	t->n--;
+	return;
+}
+#endif
+#endif
+
+static inline tbl_size_t _count(struct tbl *t)
+{
+#ifdef TBL_INCREMENTAL
+	if (t->old)
+		return t->n + t->old->n;
+#endif
+	return t->n;
+}
+
+static inline tbl_size_t _load(struct tbl *t)
+{
+#ifdef TBL_SWISS
+	return _count(t) + t->dead;
+#else
+	return _count(t);
+#endif
+}
+
+#ifdef TBL_INCREMENTAL
+static inline void _migrate(struct tbl *t, tbl_size_t steps)
+{
+	struct tbl *old = t->old;
+	if (!old)
+		return;
+	while (steps-- && old->n){
+		struct tbl_bkt *b = &old->a[t->mpos];
+		if (b->value){
+			_place(t, b, _hashat(old, t->mpos));
+			_erase(old, b);
+		}else{
+			t->mpos++;
+		}
+	}
+	if (!old->n){
+		free(old->a);
+		free(old);
+		t->old = NULL;
+		t->mpos = 0;
+	}
+	return;
+}
+#else
+static inline void _migrate(struct tbl *t, tbl_size_t steps)
+{
+	(void)t;
+	(void)steps;
+	return;
+}
+#endif
+
+static inline int _put(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	assert(t && e->value);
+	if (t->n == t->max)
+		return -1;
+	return _place(t, e, hash);
+}
+
+/* Pulls in the memory _find() reads first for hash. */
+static inline void _prefetch(struct tbl *t, tbl_hash_t hash)
+{
+#ifdef __GNUC__
+	tbl_size_t pos = hash & t->hashmask;
+#if defined(TBL_SWISS)
+	__builtin_prefetch(t->ctrl + (pos & ~(tbl_size_t)(TBL_GROUP - 1)));
+#elif defined(TBL_SOA)
+	__builtin_prefetch(t->hash + pos);
+#elif defined(TBL_CUCKOO)
+	__builtin_prefetch(&t->a[_bkt2(t, hash) * TBL_SLOTS]);
+	pos = _bkt1(t, hash) * TBL_SLOTS;
+#endif
+	__builtin_prefetch(&t->a[pos]);
+#else
+	(void)t;
+	(void)hash;
+#endif
+	return;
+}
+
+/* hash[i] = _hash(t, keys[i], keylens[i]). Hashing a whole batch before
+ * probing lets the independent hash chains overlap, and each key's first
+ * probe is prefetched while the rest of the batch is hashed. */
+static inline void _hash_batch(struct tbl *t, const char **keys, const size_t *keylens, tbl_hash_t *hash, size_t n)
+{
+	for (size_t i=0; i != n; i++){
+		hash[i] = _hash(t, keys[i], keylens[i]);
+		_prefetch(t, hash[i]);
+	}
+	return;
+}
+
+static inline void *_get(struct tbl *t, const char *key, size_t keylen, tbl_hash_t hash)
+{
+	assert(t && key);
+	struct tbl_bkt *b = _find(t, key, keylen, hash);
+#ifdef TBL_INCREMENTAL
+	if (!b && t->old)
+		b = _find(t->old, key, keylen, hash);
+#endif
+	if (!b)
+		return NULL;
+#ifdef TBL_MAP
+	return b->data;
+#else
+	return b->value;
+#endif
+}
+
+static inline void *_remove(struct tbl *t, const char *key, size_t keylen)
+{
+	assert(t && key);
+	tbl_hash_t hash = _hash(t, key, keylen);
+	struct tbl *owner = t;
+	struct tbl_bkt *b = _find(t, key, keylen, hash);
+	void *found;
+
+#ifdef TBL_INCREMENTAL
+	if (!b && t->old)
+		b = _find(owner = t->old, key, keylen, hash);
+#endif
+	if (!b)
+		return NULL;
+#ifdef TBL_MAP
+	found = b->data;
+#else
+	found = b->value;
+#endif
+	_erase(owner, b);
+	return found;
+}
+
+/* hash is the key's _hash(), which only depends on the table seed and so
+ * survives the resizes below. Callers that already hashed the key pass it
+ * in rather than reading the key again. */
+static int _insert(struct tbl *t, const struct tbl_bkt *e, tbl_hash_t hash)
+{
+	_migrate(t, TBL_MIGRATE_STEP);
+	while (_load(t) >= t->grow_at){
+		if (tbl_grow(t))
+			return -1;
+	}
+	if (!_put(t, e, hash))
+		return 0;
+	/* Cuckoo and hopscotch can refuse a key at any load, e.g. one hash
+	 * repeated past a bucket pair or neighborhood, which no amount of
+	 * growing fixes. Grow once, and only while the table is at least half
+	 * way to grow_at, which unlike shrink_at the policy cannot zero. */
+	if (_load(t) < t->grow_at / 2 || tbl_grow(t))
+		return -1;
+	return _put(t, e, hash);
+}
+
+static inline int _copy(struct tbl *dest, struct tbl *src)
 {
 	assert(src && dest);
 	assert(dest->max >= src->max);
-	for (unsigned int i=0; i != src->max; i++){
-		if (src->a[i].value)
-			_put(dest, src->a[i].value);
+	for (tbl_size_t i=0; i != src->max; i++){
+		if (src->a[i].value && _insert(dest, &src->a[i], _hash(dest, src->a[i].value, src->a[i].len)))
+			return -1;
 	}
-	return;
+	return 0;
+}
+
+static inline int _rehash(struct tbl *dest, struct tbl *src)
+{
+	assert(src && dest);
+	assert(dest->seed == src->seed);
+	for (tbl_size_t i=0; i != src->max; i++){
+		if (src->a[i].value && _place(dest, &src->a[i], _hashat(src, i)))
+			return -1;
+	}
+	return 0;
+}
+
+static int _resize(struct tbl *t, unsigned int n_lg2)
+{
+	assert(t && n_lg2);
+	struct tbl old_t;
+	struct tbl_bkt *array;
+#ifdef TBL_INCREMENTAL
+	struct tbl *old;
+	_migrate(t, MIGRATE_ALL);
+	if (!(old = malloc(sizeof(struct tbl))))
+		return -1;
+#endif
+	array = _alloc(n_lg2);
+	if (!array){
+#ifdef TBL_INCREMENTAL
+		free(old);
+#endif
+		return -1;
+	}
+	memcpy(&old_t, t, sizeof(struct tbl));
+	memset(t, 0, sizeof(struct tbl));
+	t->policy = old_t.policy;
+#ifdef TBL_HASH_FN
+	t->hashfn = old_t.hashfn;
+#endif
+#ifdef TBL_HAS_SECRET
+	memcpy(t->secret, old_t.secret, TBL_SECRET_SIZE);
+#endif
+	_init(t, array, n_lg2);
+#ifdef TBL_INCREMENTAL
+	memcpy(old, &old_t, sizeof(struct tbl));
+	t->old = old;
+#else
+	if (_rehash(t, &old_t)){
+		free(array);
+		memcpy(t, &old_t, sizeof(struct tbl));
+		return _resize(t, n_lg2 + 1);
+	}
+	free(old_t.a);
+#endif
+	return 0;
+}
+
+static inline unsigned int _fit(const struct tbl_policy *p, tbl_size_t n)
+{
+	unsigned int lg2 = TBL_DEFAULT_SIZE_LG2;
+	while (lg2 < TBL_MAX_LG2 && n > _tbl_limit(p->max_load, (tbl_size_t)1 << lg2))
+		lg2++;
+	return lg2;
 }
 
 struct tbl *tbl_create(void)
 {
+	return tbl_create_with_capacity(0);
+}
+
+struct tbl *tbl_create_with_capacity(tbl_size_t n)
+{
+	unsigned int n_lg2 = _fit(&_default_policy, n);
 	struct tbl *t = malloc(sizeof(struct tbl));
 	if (!t)
 		return NULL;
-	struct tbl_bkt *array = malloc(sizeof(struct tbl_bkt) * TBL_DEFAULT_SIZE);
+	struct tbl_bkt *array = _alloc(n_lg2);
 	if (!array){
 		free(t);
 		return NULL;
 	}
-	_init(t, array, TBL_DEFAULT_SIZE_LG2);
+	memset(t, 0, sizeof(struct tbl));
+	t->policy = _default_policy;
+#ifdef TBL_HASH_FN
+	t->hashfn = DEFAULT_HASH;
+#endif
+	_init(t, array, n_lg2);
+#ifdef TBL_HAS_SECRET
+	XXH3_generateSecret_fromSeed(t->secret, t->seed);
+#endif
 	return t;
 }
 
 int tbl_put(struct tbl *t, void *value)
 {
 	assert(t && value);
-	if (t->max >> TBL_FREE_BUCKET_RATIO_LG2 != t->max - t->n){
-		return _put(t, value);
-	}else{
-		if (tbl_grow(t) && _put(t, value))
-			return -1;
+	return tbl_put_n(t, value, _keylen((char*)value));
+}
+
+int tbl_put_n(struct tbl *t, void *value, size_t keylen)
+{
+	struct tbl_bkt e = {0};
+	assert(t && value);
+	if (_badlen(keylen))
+		return -1;
+	_entry(&e, value, keylen);
+#ifdef TBL_MAP
+	e.data = value;
+#endif
+	return _insert(t, &e, _hash(t, value, keylen));
+}
+
+#ifdef TBL_MAP
+int tbl_put_kv(struct tbl *t, const char *key, void *value)
+{
+	assert(t && key);
+	return tbl_put_kv_n(t, key, _keylen(key), value);
+}
+
+int tbl_put_kv_n(struct tbl *t, const char *key, size_t keylen, void *value)
+{
+	struct tbl_bkt e = {0}, *b;
+	tbl_hash_t hash;
+	assert(t && key && value);
+	if (_badlen(keylen))
+		return -1;
+	/* an existing key only gets its data replaced */
+	hash = _hash(t, key, keylen);
+	b = _find(t, key, keylen, hash);
+#ifdef TBL_INCREMENTAL
+	if (!b && t->old)
+		b = _find(t->old, key, keylen, hash);
+#endif
+	if (b){
+		b->data = value;
+		return 0;
 	}
+	_entry(&e, key, keylen);
+	e.data = value;
+	return _insert(t, &e, hash);
 }
+#endif
 
 void *tbl_get(struct tbl *t, const char *key)
 {
-	return _get(t, key);
+	assert(t && key);
+	return tbl_get_n(t, key, _keylen(key));
+}
+
+void *tbl_get_n(struct tbl *t, const char *key, size_t keylen)
+{
+	if (_badlen(keylen))
+		return NULL;
+	_migrate(t, TBL_MIGRATE_STEP);
+	return _get(t, key, keylen, _hash(t, key, keylen));
+}
+
+size_t tbl_get_batch(struct tbl *t, const char **keys, const size_t *keylens, void **out, size_t n)
+{
+	assert(t && keys && out);
+	const char *ks[BATCH];
+	size_t lens[BATCH], idx[BATCH];
+	tbl_hash_t hash[BATCH];
+	size_t found = 0;
+	for (size_t i=0; i != n; ){
+		size_t m = n - i < BATCH ? n - i : BATCH, k = 0;
+		/* keys of a bad length are never read, as in tbl_get_n() */
+		for (size_t j=0; j != m; j++){
+			out[i+j] = NULL;
+			lens[k] = keylens ? keylens[i+j] : _keylen(keys[i+j]);
+			if (_badlen(lens[k]))
+				continue;
+			ks[k] = keys[i+j];
+			idx[k++] = i + j;
+		}
+		_hash_batch(t, ks, lens, hash, k);
+		for (size_t j=0; j != k; j++){
+			_migrate(t, TBL_MIGRATE_STEP);
+			if ((out[idx[j]] = _get(t, ks[j], lens[j], hash[j])))
+				found++;
+		}
+		i += m;
+	}
+	return found;
 }
 
 void *tbl_remove(struct tbl *t, const char *key)
 {
-	return _remove(t, key);
+	assert(t && key);
+	return tbl_remove_n(t, key, _keylen(key));
+}
+
+void *tbl_remove_n(struct tbl *t, const char *key, size_t keylen)
+{
+	void *found;
+	if (_badlen(keylen))
+		return NULL;
+	_migrate(t, TBL_MIGRATE_STEP);
+	found = _remove(t, key, keylen);
+#ifdef TBL_INCREMENTAL
+	/* _resize would finish the pending migration in this one call */
+	if (t->old)
+		return found;
+#endif
+	if (found && _count(t) < t->shrink_at && t->max_lg2 > TBL_DEFAULT_SIZE_LG2)
+		_resize(t, t->max_lg2 - 1);
+	return found;
 }
 
 int tbl_grow(struct tbl *t)
 {
 	assert(t);
-	struct tbl old_t;
-	struct tbl_bkt *array = malloc(sizeof(struct tbl_bkt) << (t->max_lg2 + 1));
-	if (!array){
+	if (t->max_lg2 + t->policy.grow_lg2 > TBL_MAX_LG2)
 		return -1;
-	}
-	memcpy(&old_t, t, sizeof(struct tbl));
-	memset(t, 0, sizeof(struct tbl));
-	_init(t, array, (t->max_lg2 + 1));
-	_copy(t, &old_t);
-	free(old_t.a);
+	return _resize(t, t->max_lg2 + t->policy.grow_lg2);
+}
+
+int tbl_reserve(struct tbl *t, tbl_size_t n)
+{
+	assert(t);
+	unsigned int n_lg2 = _fit(&t->policy, n);
+	if (n_lg2 <= t->max_lg2)
+		return 0;
+	return _resize(t, n_lg2);
+}
+
+int tbl_shrink_to_fit(struct tbl *t)
+{
+	assert(t);
+	unsigned int n_lg2 = _fit(&t->policy, _count(t));
+	if (n_lg2 >= t->max_lg2)
+		return 0;
+	if (_resize(t, n_lg2))
+		return -1;
+	_migrate(t, MIGRATE_ALL);
+	return 0;
+}
+
+int tbl_set_policy(struct tbl *t, const struct tbl_policy *p)
+{
+	assert(t && p);
+	if (!p->max_load || p->max_load > 100 || p->min_load > (p->max_load - 1) / 2)
+		return -1;
+	if (!p->grow_lg2 || p->grow_lg2 > 8)
+		return -1;
+#ifdef TBL_INCREMENTAL
+	/* A migration takes a step per old bucket and per entry moved, and
+	 * every put takes TBL_MIGRATE_STEP of them. The puts between a grow
+	 * and the next one, or between a halving and the next grow, must be
+	 * enough to finish it there. */
+	unsigned long long step = TBL_MIGRATE_STEP;
+	if (step * p->max_load * ((1u << p->grow_lg2) - 1) < 100 + p->max_load)
+		return -1;
+	if (p->min_load && step * (p->max_load - 2 * p->min_load) < 2 * (100 + p->min_load))
+		return -1;
+#endif
+	t->policy = *p;
+	_bounds(t);
 	return 0;
 }
 
 int tbl_copy(struct tbl *dest, struct tbl *src)
 {
 	assert(dest && src);
+	_migrate(src, MIGRATE_ALL);
 	while (dest->max < src->max){
 		if (tbl_grow(dest))
 			return -1;
 	}
-	_copy(dest, src);
-	return 0;
+	_migrate(dest, MIGRATE_ALL);
+	return _copy(dest, src);
 }
 
 void tbl_free(struct tbl *t)
+{
+#ifdef TBL_INCREMENTAL
+	if (t->old){
+		free(t->old->a);
+		free(t->old);
+	}
+#endif
+	free(t->a);
+	free(t);
+	return;
+}
+
+uint64_t tbl_hash_xxh3(const void *key, size_t len, uint64_t seed)
+{
+	return XXH3_64bits_withSeed(key, len, seed);
+}
+
+uint64_t tbl_hash_xxh3_128(const void *key, size_t len, uint64_t seed)
+{
+	XXH128_hash_t h = XXH3_128bits_withSeed(key, len, seed);
+	return h.low64 ^ h.high64;
+}
+
+uint64_t tbl_hash_wy(const void *key, size_t len, uint64_t seed)
+{
+	return _hash_wy(key, len, seed);
+}
+
+uint64_t tbl_hash_crc32c(const void *key, size_t len, uint64_t seed)
+{
+	return _hash_crc32c(key, len, seed);
+}
+
+tbl_hash_t tbl_hash(struct tbl *t, const char *key, size_t keylen)
+{
+	assert(t && key);
+	return _hash(t, key, keylen);
+}
+
+#ifdef TBL_HASH_FN
+int tbl_set_hash(struct tbl *t, tbl_hash_fn fn)
+{
+	assert(t);
+	if (t->n)
+		return -1;
+#ifdef TBL_INCREMENTAL
+	if (t->old && t->old->n)
+		return -1;
+#endif
+	t->hashfn = fn ? fn : DEFAULT_HASH;
+	return 0;
+}
+#endif
+
+static inline tbl_size_t _u64_home(struct tbl_u64 *t, uint64_t key)
+{
+	return (tbl_size_t)XXH3_avalanche(key ^ t->seed) & t->hashmask;
+}
+
+/* Bucket holding key, or the free bucket ending its probe run. */
+static inline tbl_size_t _u64_slot(struct tbl_u64 *t, uint64_t key)
+{
+	tbl_size_t pos = _u64_home(t, key);
+	while (t->a[pos].key != key && t->a[pos].key != TBL_U64_EMPTY)
+		pos = (pos + 1) & t->hashmask;
+	return pos;
+}
+
+static inline int _u64_init(struct tbl_u64 *t, unsigned int n_lg2)
+{
+	assert(t && n_lg2);
+	struct tbl_u64_bkt *array = malloc(sizeof(struct tbl_u64_bkt) << n_lg2);
+	if (!array)
+		return -1;
+	for (tbl_size_t i=0; i != (tbl_size_t)1 << n_lg2; i++)
+		array[i].key = TBL_U64_EMPTY;
+	t->a = array;
+	t->n = 0;
+	t->max = (tbl_size_t)1 << n_lg2;
+	t->max_lg2 = n_lg2;
+	t->hashmask = t->max - 1;
+	t->grow_at = _tbl_limit(t->policy.max_load, t->max);
+	t->shrink_at = _tbl_limit(t->policy.min_load, t->max);
+	return 0;
+}
+
+static int _u64_resize(struct tbl_u64 *t, unsigned int n_lg2)
+{
+	assert(t && n_lg2);
+	struct tbl_u64 old_t = *t;
+	if (_u64_init(t, n_lg2))
+		return -1;
+	for (tbl_size_t i=0; i != old_t.max; i++){
+		if (old_t.a[i].key != TBL_U64_EMPTY){
+			t->a[_u64_slot(t, old_t.a[i].key)] = old_t.a[i];
+			t->n++;
+		}
+	}
+	free(old_t.a);
+	return 0;
+}
+
+struct tbl_u64 *tbl_u64_create(void)
+{
+	struct tbl_u64 *t = malloc(sizeof(struct tbl_u64));
+	if (!t)
+		return NULL;
+	memset(t, 0, sizeof(struct tbl_u64));
+	t->seed = (uintptr_t)t;
+	t->policy = _default_policy;
+	if (_u64_init(t, TBL_DEFAULT_SIZE_LG2)){
+		free(t);
+		return NULL;
+	}
+	return t;
+}
+
+int tbl_u64_put(struct tbl_u64 *t, uint64_t key, void *value)
+{
+	assert(t && value);
+	tbl_size_t pos;
+	if (key == TBL_U64_EMPTY)
+		return -1;
+	pos = _u64_slot(t, key);
+	if (t->a[pos].key == key){
+		t->a[pos].value = value;
+		return 0;
+	}
+	if (t->n >= t->grow_at){
+		if (t->max_lg2 + t->policy.grow_lg2 > TBL_MAX_LG2 || _u64_resize(t, t->max_lg2 + t->policy.grow_lg2))
+			return -1;
+		pos = _u64_slot(t, key);
+	}
+	t->a[pos].key = key;
+	t->a[pos].value = value;
+	t->n++;
+	return 0;
+}
+
+void *tbl_u64_get(struct tbl_u64 *t, uint64_t key)
+{
+	assert(t);
+	tbl_size_t pos = _u64_slot(t, key);
+	if (key == TBL_U64_EMPTY || t->a[pos].key != key)
+		return NULL;
+	return t->a[pos].value;
+}
+
+void *tbl_u64_remove(struct tbl_u64 *t, uint64_t key)
+{
+	assert(t);
+	tbl_size_t pos = _u64_slot(t, key), next;
+	void *found;
+	if (key == TBL_U64_EMPTY || t->a[pos].key != key)
+		return NULL;
+	found = t->a[pos].value;
+	for (next = (pos + 1) & t->hashmask; t->a[next].key != TBL_U64_EMPTY; next = (next + 1) & t->hashmask){
+		if (_tbl_shift(_u64_home(t, t->a[next].key), pos, next, t->hashmask)){
+			t->a[pos] = t->a[next];
+			pos = next;
+		}
+	}
+	t->a[pos].key = TBL_U64_EMPTY;
+	t->n--;
+	if (t->n < t->shrink_at && t->max_lg2 > TBL_DEFAULT_SIZE_LG2)
+		_u64_resize(t, t->max_lg2 - 1);
+	return found;
+}
+
+void tbl_u64_free(struct tbl_u64 *t)
 {
 	free(t->a);
 	free(t);
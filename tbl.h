@@ -23,45 +23,565 @@
 #define TBL_H
 
 #include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+#include <type_traits>
+
+extern "C" {
+#endif
 
 #define TBL_VERSION_STR "0.3"
 
 #ifndef TBL_DEFAULT_SIZE
+#ifdef TBL_SWISS
+#define TBL_DEFAULT_SIZE 16
+#define TBL_DEFAULT_SIZE_LG2 4
+#else
 #define TBL_DEFAULT_SIZE 8
 #define TBL_DEFAULT_SIZE_LG2 3
 #endif
+#endif
 
 #ifndef TBL_FREE_BUCKET_RATIO
 #define TBL_FREE_BUCKET_RATIO 4
 #define TBL_FREE_BUCKET_RATIO_LG2 2
 #endif
 
-#define TBL_MAX ULONG_MAX
+#ifndef TBL_MAX_LOAD
+#define TBL_MAX_LOAD (100 - 100 / TBL_FREE_BUCKET_RATIO)
+#endif
+
+#ifndef TBL_MIN_LOAD
+#define TBL_MIN_LOAD (TBL_MAX_LOAD / 4)
+#endif
+
+#ifndef TBL_GROW_LG2
+#define TBL_GROW_LG2 1
+#endif
+
+#ifndef TBL_MIGRATE_STEP
+#define TBL_MIGRATE_STEP 16
+#endif
+
+/* Define TBL_ROBIN_HOOD to keep every probe run ordered by displacement.
+ * Lookups for absent keys then stop at the first poorer bucket, so dense
+ * tables (TBL_FREE_BUCKET_RATIO 16) stay cheap on misses.
+ *
+ * Define TBL_BACKWARD_SHIFT to have tbl_remove pull the rest of a cluster
+ * back into the freed bucket and lower maxoff to match, instead of leaving
+ * a hole. Robin Hood tables always remove this way.
+ *
+ * Define TBL_INCREMENTAL to spread tbl_grow over later calls: the old
+ * bucket array is kept next to the new one and every tbl_put, tbl_get and
+ * tbl_remove moves up to TBL_MIGRATE_STEP of its buckets across.
+ * tbl_set_policy() rejects policies under which puts alone could not
+ * finish a migration before the next resize, and tbl_remove does not
+ * shrink while one is pending.
+ *
+ * Define TBL_SWISS to keep a byte of control data per bucket (7 bits of
+ * hash, or empty/deleted) in its own array and probe it TBL_GROUP buckets
+ * at a time with SSE2. Buckets are only read on a control byte match.
+ * Removed buckets become tombstones, which count towards the load until
+ * the next tbl_grow.
+ *
+ * Define TBL_SOA to keep values, hashes and maxoff in separate arrays.
+ * Lookups compare the probe window against the hash array eight buckets
+ * at a time (AVX2 when available) and only read values on a match.
+ *
+ * Define TBL_CUCKOO for bucketized cuckoo hashing: every hash maps to two
+ * buckets of TBL_SLOTS slots and lookups read nothing else. Inserts move
+ * residents to their other bucket along a path of at most TBL_CUCKOO_KICKS
+ * steps and fall back to one tbl_grow when none is found, so the table can
+ * be run with TBL_FREE_BUCKET_RATIO 32. At most 2 * TBL_SLOTS entries can
+ * share a hash; tbl_put() of a key already stored that often returns -1.
+ *
+ * Define TBL_HOPSCOTCH to replace maxoff with a bitmap of which of the
+ * next TBL_HOP buckets hold entries homed at this one. Lookups read only
+ * those buckets; inserts hop entries backwards until the new one lands
+ * inside its neighborhood, and fall back to one tbl_grow if they cannot.
+ * A neighborhood holds at most TBL_HOP entries with the same hash, so
+ * tbl_put() of a key already stored that often returns -1.
+ *
+ * Define TBL_MAP to turn the table into a map: buckets keep a data pointer
+ * next to the key pointer in value, tbl_put_kv() sets both (or replaces
+ * the data of a key already present), and tbl_get() and tbl_remove()
+ * return the data. tbl_put() still works and maps a key to itself.
+ *
+ * Define TBL_INLINE_KEY to a byte count to copy keys up to that length into
+ * the bucket itself. Comparisons against short keys then stay inside the
+ * bucket array and only longer keys are read through the value pointer,
+ * at the cost of a larger bucket. The pointer is still kept for every
+ * entry, since it is what tbl_get() returns outside of TBL_MAP.
+ *
+ * Define TBL_KEY_WIDTH to 16 or 32 for fixed size binary keys such as UUIDs
+ * or digests. Every key is then exactly that many bytes: tbl_put() and
+ * friends read TBL_KEY_WIDTH bytes instead of calling strlen, the _n
+ * variants reject any other length, and keys are kept inline and compared
+ * with one SSE2 or AVX2 compare. Keys that are already uniformly random
+ * can also define TBL_KEY_RAW_HASH to use their leading bytes as the
+ * hash and skip XXH3.
+ *
+ * Define TBL_WIDE for tables past 2^32 buckets. Counts and bucket indices
+ * become size_t and the full 64 bits of XXH3 are stored per bucket, so
+ * different keys with equal stored hashes stay rare at that size. The
+ * default keeps both at unsigned int for smaller buckets.
+ *
+ * Define TBL_DISPATCH on x86 with GCC or Clang to build the XXH3 long key
+ * loop for SSE2, AVX2 and AVX-512 and pick the widest one the host
+ * supports at run time, so a baseline x86-64 build still hashes long keys
+ * with AVX2 or AVX-512 where available. Keys of up to 240 bytes never
+ * reach that loop and are unaffected. It only applies to TBL_HASH_XXH3.
+ *
+ * Define TBL_HASH to choose the key hash, which is then inlined:
+ *   TBL_HASH_XXH3      XXH3 64-bit (the default)
+ *   TBL_HASH_XXH3_128  XXH3 128-bit with both halves xored together
+ *   TBL_HASH_WY        wyhash style multiply and fold mixer
+ *   TBL_HASH_CRC32C    two CRC32C lanes and a multiply finalizer, using the
+ *                      SSE4.2 crc32 instruction when built with it and a
+ *                      slow bitwise loop otherwise
+ * Define TBL_HASH_FN to call the hash through a pointer in each table
+ * instead. Tables start with the TBL_HASH choice and tbl_set_hash() swaps
+ * it for any tbl_hash_fn while the table is empty. */
+
+#ifdef TBL_SWISS
+#define TBL_GROUP 16
+#if TBL_DEFAULT_SIZE < TBL_GROUP
+#error "TBL_SWISS needs TBL_DEFAULT_SIZE of at least TBL_GROUP"
+#endif
+#if defined(TBL_ROBIN_HOOD) || defined(TBL_BACKWARD_SHIFT)
+#error "TBL_SWISS cannot be combined with TBL_ROBIN_HOOD or TBL_BACKWARD_SHIFT"
+#endif
+#endif
+
+#ifdef TBL_CUCKOO
+#define TBL_SLOTS 4
+#ifndef TBL_CUCKOO_KICKS
+#define TBL_CUCKOO_KICKS 256
+#endif
+#if defined(TBL_SWISS) || defined(TBL_SOA) || defined(TBL_ROBIN_HOOD) || defined(TBL_BACKWARD_SHIFT) || defined(TBL_INCREMENTAL)
+#error "TBL_CUCKOO cannot be combined with other modes"
+#endif
+#endif
+
+#ifdef TBL_HOPSCOTCH
+#define TBL_HOP 32
+#if defined(TBL_SWISS) || defined(TBL_SOA) || defined(TBL_CUCKOO) || defined(TBL_ROBIN_HOOD) || defined(TBL_BACKWARD_SHIFT) || defined(TBL_INCREMENTAL)
+#error "TBL_HOPSCOTCH cannot be combined with other modes"
+#endif
+#endif
+
+#if defined(TBL_SOA) && (defined(TBL_SWISS) || defined(TBL_ROBIN_HOOD) || defined(TBL_BACKWARD_SHIFT))
+#error "TBL_SOA uses plain linear probing and cannot be combined with other modes"
+#endif
+
+#ifdef TBL_KEY_WIDTH
+#if TBL_KEY_WIDTH != 16 && TBL_KEY_WIDTH != 32
+#error "TBL_KEY_WIDTH must be 16 or 32"
+#endif
+#ifndef TBL_INLINE_KEY
+#define TBL_INLINE_KEY TBL_KEY_WIDTH
+#elif TBL_INLINE_KEY != TBL_KEY_WIDTH
+#error "TBL_INLINE_KEY must equal TBL_KEY_WIDTH"
+#endif
+#elif defined(TBL_KEY_RAW_HASH)
+#error "TBL_KEY_RAW_HASH needs TBL_KEY_WIDTH"
+#endif
+
+#define TBL_HASH_XXH3 1
+#define TBL_HASH_XXH3_128 2
+#define TBL_HASH_WY 3
+#define TBL_HASH_CRC32C 4
+
+#ifndef TBL_HASH
+#define TBL_HASH TBL_HASH_XXH3
+#endif
+
+#if TBL_HASH < TBL_HASH_XXH3 || TBL_HASH > TBL_HASH_CRC32C
+#error "TBL_HASH must be one of the TBL_HASH_* values"
+#endif
+
+#if defined(TBL_KEY_RAW_HASH) && (defined(TBL_HASH_FN) || TBL_HASH != TBL_HASH_XXH3)
+#error "TBL_KEY_RAW_HASH cannot be combined with TBL_HASH or TBL_HASH_FN"
+#endif
+
+#if defined(TBL_INLINE_KEY) && TBL_INLINE_KEY + 0 <= 0
+#error "TBL_INLINE_KEY must be a positive byte count"
+#endif
+
+#ifdef TBL_WIDE
+typedef uint64_t tbl_hash_t;
+typedef size_t tbl_size_t;
+#else
+typedef unsigned int tbl_hash_t;
+typedef unsigned int tbl_size_t;
+#endif
+
+/* Hashes len bytes at key. Only the low bits are kept without TBL_WIDE. */
+typedef uint64_t (*tbl_hash_fn)(const void *key, size_t len, uint64_t seed);
+
+#define TBL_MAX ((tbl_size_t)-1)
+#define TBL_MAX_LG2 (sizeof(tbl_size_t) * CHAR_BIT - 1)
 
+/* Shared by tbl, tbl_u64 and TBL_DEFINE. The entry count allowed at load
+ * percent of max buckets, always leaving one bucket free so probes end. */
+static inline tbl_size_t _tbl_limit(unsigned int load, tbl_size_t max)
+{
+	tbl_size_t n = max / 100 * load + max % 100 * load / 100;
+	return n < max ? n : max - 1;
+}
+
+/* Backward shift removal: whether the entry at pos, whose home bucket is
+ * home, moves into the hole, i.e. home does not lie between hole and pos. */
+static inline int _tbl_shift(tbl_size_t home, tbl_size_t hole, tbl_size_t pos, tbl_size_t mask)
+{
+	return ((pos - home) & mask) >= ((pos - hole) & mask);
+}
+
+/* XXH3 secret derived from the table seed once at creation, so keys
+ * longer than 240 bytes hash without rederiving it on every call. Only
+ * kept when the hash may be XXH3. */
+#define TBL_SECRET_SIZE 192
+#if !defined(TBL_KEY_RAW_HASH) && (defined(TBL_HASH_FN) || TBL_HASH == TBL_HASH_XXH3 || TBL_HASH == TBL_HASH_XXH3_128)
+#define TBL_HAS_SECRET 1
+#endif
+
+#if defined(TBL_SOA)
+struct tbl_bkt{
+	void *value;
+	unsigned int len;
+#ifdef TBL_MAP
+	void *data;
+#endif
+#ifdef TBL_INLINE_KEY
+	char key[TBL_INLINE_KEY];
+#endif
+};
+#elif defined(TBL_HOPSCOTCH)
+struct tbl_bkt{
+	void *value;
+	tbl_hash_t hash;
+	unsigned int len;
+	unsigned int hop;
+#ifdef TBL_MAP
+	void *data;
+#endif
+#ifdef TBL_INLINE_KEY
+	char key[TBL_INLINE_KEY];
+#endif
+};
+#elif defined(TBL_ROBIN_HOOD) || defined(TBL_SWISS) || defined(TBL_CUCKOO)
 struct tbl_bkt{
 	void *value;
-	unsigned int hash;
+	tbl_hash_t hash;
+	unsigned int len;
+#ifdef TBL_MAP
+	void *data;
+#endif
+#ifdef TBL_INLINE_KEY
+	char key[TBL_INLINE_KEY];
+#endif
+};
+#else
+struct tbl_bkt{
+	void *value;
+	tbl_hash_t hash;
+	unsigned int len;
 	unsigned int maxoff;
+#ifdef TBL_MAP
+	void *data;
+#endif
+#ifdef TBL_INLINE_KEY
+	char key[TBL_INLINE_KEY];
+#endif
+};
+#endif
+
+/* Per table resizing policy, see tbl_set_policy(). Loads are percentages
+ * of the bucket array in use: tbl_put grows the table by 1 << grow_lg2
+ * once max_load is reached and tbl_remove halves it below min_load (0
+ * never shrinks). min_load must stay under half of max_load, so a halved
+ * table sits well clear of both marks. tbl_shrink_to_fit() rebuilds into
+ * the smallest array that holds the current entries below max_load. */
+struct tbl_policy{
+	unsigned int max_load;
+	unsigned int min_load;
+	unsigned int grow_lg2;
 };
 
 struct tbl{
         struct tbl_bkt *a;
         unsigned long seed;
-        unsigned int n;
-        unsigned int max;
+#ifdef TBL_HASH_FN
+        tbl_hash_fn hashfn;
+#endif
+        tbl_size_t n;
+        tbl_size_t max;
         unsigned int max_lg2;
-        unsigned int hashmask;
+        tbl_size_t hashmask;
+        tbl_size_t grow_at;
+        tbl_size_t shrink_at;
+        struct tbl_policy policy;
+#ifdef TBL_SWISS
+        unsigned char *ctrl;
+        tbl_size_t dead;
+#endif
+#ifdef TBL_SOA
+        tbl_hash_t *hash;
+        unsigned int *maxoff;
+#endif
+#ifdef TBL_INCREMENTAL
+        struct tbl *old;
+        tbl_size_t mpos;
+#endif
+#ifdef TBL_HAS_SECRET
+        unsigned char secret[TBL_SECRET_SIZE];
+#endif
 };
 
 struct tbl *tbl_create(void);
+struct tbl *tbl_create_with_capacity(tbl_size_t n);
 
 int tbl_put(struct tbl *t, void *value);
 void *tbl_get(struct tbl *t, const char *key);
 void *tbl_remove(struct tbl *t, const char *key);
 
+/* Same as above, but the key is the first keylen bytes at value or key
+ * and need not be NUL-terminated. With TBL_KEY_WIDTH, keylen must be
+ * TBL_KEY_WIDTH. */
+int tbl_put_n(struct tbl *t, void *value, size_t keylen);
+void *tbl_get_n(struct tbl *t, const char *key, size_t keylen);
+void *tbl_remove_n(struct tbl *t, const char *key, size_t keylen);
+
+/* Looks up n keys at once, storing each result (or NULL) in out and
+ * returning how many were found. keylens may be NULL for NUL-terminated
+ * keys. Keys are hashed and prefetched in groups before probing, which
+ * hides most cache misses on tables that do not fit in cache. */
+size_t tbl_get_batch(struct tbl *t, const char **keys, const size_t *keylens, void **out, size_t n);
+
+#ifdef TBL_MAP
+int tbl_put_kv(struct tbl *t, const char *key, void *value);
+int tbl_put_kv_n(struct tbl *t, const char *key, size_t keylen, void *value);
+#endif
+
 int tbl_grow(struct tbl *t);
+int tbl_reserve(struct tbl *t, tbl_size_t n);
+int tbl_shrink_to_fit(struct tbl *t);
+int tbl_set_policy(struct tbl *t, const struct tbl_policy *p);
 int tbl_copy(struct tbl *dest, struct tbl *src);
 
 void tbl_free(struct tbl *t);
 
+/* The TBL_HASH choices as plain functions, for tbl_set_hash() or outside
+ * use. Each returns the same value the inlined choice stores. */
+uint64_t tbl_hash_xxh3(const void *key, size_t len, uint64_t seed);
+uint64_t tbl_hash_xxh3_128(const void *key, size_t len, uint64_t seed);
+uint64_t tbl_hash_wy(const void *key, size_t len, uint64_t seed);
+uint64_t tbl_hash_crc32c(const void *key, size_t len, uint64_t seed);
+
+/* The hash t stores for the keylen bytes at key, including the table seed
+ * and the secret derived from it. */
+tbl_hash_t tbl_hash(struct tbl *t, const char *key, size_t keylen);
+
+#ifdef TBL_HASH_FN
+int tbl_set_hash(struct tbl *t, tbl_hash_fn fn);
+#endif
+
+/* Integer keyed map. It does not depend on the engine selected above: it
+ * is always plain linear probing with backward shift removal over buckets
+ * that hold the key itself. Keys are mixed with the XXH3 avalanche step
+ * rather than hashed as text. A bucket whose key is TBL_U64_EMPTY is free,
+ * so that key cannot be stored. The table follows the default tbl_policy. */
+#define TBL_U64_EMPTY UINT64_MAX
+
+struct tbl_u64_bkt{
+	uint64_t key;
+	void *value;
+};
+
+struct tbl_u64{
+        struct tbl_u64_bkt *a;
+        uint64_t seed;
+        tbl_size_t n;
+        tbl_size_t max;
+        unsigned int max_lg2;
+        tbl_size_t hashmask;
+        tbl_size_t grow_at;
+        tbl_size_t shrink_at;
+        struct tbl_policy policy;
+};
+
+struct tbl_u64 *tbl_u64_create(void);
+int tbl_u64_put(struct tbl_u64 *t, uint64_t key, void *value);
+void *tbl_u64_get(struct tbl_u64 *t, uint64_t key);
+void *tbl_u64_remove(struct tbl_u64 *t, uint64_t key);
+void tbl_u64_free(struct tbl_u64 *t);
+
+/* TBL_DEFINE(name, key_t, val_t, hash_fn, eq_fn) instantiates a type
+ * specialized table in the including file, with every function static
+ * inline so hash_fn and eq_fn can be inlined into the probe loop. Keys and
+ * values are stored by value in the buckets. hash_fn(key) returns an
+ * unsigned integer and eq_fn(a, b) is nonzero for equal keys; either may
+ * be a function or a macro. The table is linear probing with backward
+ * shift removal, like tbl_u64, and keeps each hash with its bucket so
+ * resizes never call hash_fn. The top bit of its tbl_hash_t marks a bucket
+ * as used, so hash_fn keeps one bit less than tbl_hash_t. It grows and
+ * shrinks at TBL_MAX_LOAD and TBL_MIN_LOAD. It defines:
+ *
+ *   struct name *name_create(void);
+ *   int name_put(struct name *t, key_t key, val_t val);
+ *   val_t *name_get(struct name *t, key_t key);
+ *   int name_remove(struct name *t, key_t key, val_t *val);
+ *   int name_grow(struct name *t);
+ *   void name_free(struct name *t);
+ *
+ * name_put replaces the value of a present key, name_get points into the
+ * bucket until the next put or remove, and name_remove returns -1 if the
+ * key is absent and stores the old value at val when val is not NULL.
+ *
+ * Buckets are calloc'd, moved by assignment and freed without running
+ * constructors or destructors, so key_t and val_t must be trivially
+ * copyable. C++ builds check this at compile time. */
+#ifdef __cplusplus
+#define _TBL_TRIVIAL(key_t, val_t) \
+static_assert(std::is_trivially_copyable<key_t>::value && std::is_trivially_copyable<val_t>::value, \
+		"TBL_DEFINE keys and values must be trivially copyable");
+#else
+#define _TBL_TRIVIAL(key_t, val_t)
+#endif
+
+#define TBL_DEFINE(name, key_t, val_t, hash_fn, eq_fn) \
+_TBL_TRIVIAL(key_t, val_t) \
+struct name##_bkt{ \
+	key_t key; \
+	val_t val; \
+	tbl_hash_t hash; \
+}; \
+\
+struct name{ \
+	struct name##_bkt *a; \
+	tbl_size_t n; \
+	tbl_size_t max; \
+	unsigned int max_lg2; \
+	tbl_size_t hashmask; \
+	tbl_size_t grow_at; \
+	tbl_size_t shrink_at; \
+}; \
+\
+static inline tbl_hash_t _##name##_hash(key_t key) \
+{ \
+	return (tbl_hash_t)(hash_fn(key)) | (tbl_hash_t)1 << (sizeof(tbl_hash_t) * CHAR_BIT - 1); \
+} \
+\
+static inline tbl_size_t _##name##_slot(struct name *t, key_t key, tbl_hash_t hash) \
+{ \
+	tbl_size_t pos = hash & t->hashmask; \
+	while (t->a[pos].hash && !(t->a[pos].hash == hash && eq_fn(t->a[pos].key, key))) \
+		pos = (pos + 1) & t->hashmask; \
+	return pos; \
+} \
+\
+static inline int _##name##_resize(struct name *t, unsigned int n_lg2) \
+{ \
+	struct name##_bkt *old = t->a; \
+	tbl_size_t old_max = t->max; \
+	struct name##_bkt *array = (struct name##_bkt *)calloc((size_t)1 << n_lg2, sizeof(struct name##_bkt)); \
+	if (!array) \
+		return -1; \
+	t->a = array; \
+	t->max = (tbl_size_t)1 << n_lg2; \
+	t->max_lg2 = n_lg2; \
+	t->hashmask = t->max - 1; \
+	t->grow_at = _tbl_limit(TBL_MAX_LOAD, t->max); \
+	t->shrink_at = _tbl_limit(TBL_MIN_LOAD, t->max); \
+	for (tbl_size_t i=0; i != old_max; i++){ \
+		if (old[i].hash){ \
+			tbl_size_t pos = old[i].hash & t->hashmask; \
+			while (t->a[pos].hash) \
+				pos = (pos + 1) & t->hashmask; \
+			t->a[pos] = old[i]; \
+		} \
+	} \
+	free(old); \
+	return 0; \
+} \
+\
+static inline struct name *name##_create(void) \
+{ \
+	struct name *t = (struct name *)calloc(1, sizeof(struct name)); \
+	if (!t) \
+		return NULL; \
+	if (_##name##_resize(t, TBL_DEFAULT_SIZE_LG2)){ \
+		free(t); \
+		return NULL; \
+	} \
+	return t; \
+} \
+\
+static inline int name##_grow(struct name *t) \
+{ \
+	if (t->max_lg2 + TBL_GROW_LG2 > TBL_MAX_LG2) \
+		return -1; \
+	return _##name##_resize(t, t->max_lg2 + TBL_GROW_LG2); \
+} \
+\
+static inline int name##_put(struct name *t, key_t key, val_t val) \
+{ \
+	tbl_hash_t hash = _##name##_hash(key); \
+	tbl_size_t pos = _##name##_slot(t, key, hash); \
+	if (t->a[pos].hash){ \
+		t->a[pos].val = val; \
+		return 0; \
+	} \
+	if (t->n >= t->grow_at){ \
+		if (name##_grow(t)) \
+			return -1; \
+		pos = _##name##_slot(t, key, hash); \
+	} \
+	t->a[pos].key = key; \
+	t->a[pos].val = val; \
+	t->a[pos].hash = hash; \
+	t->n++; \
+	return 0; \
+} \
+\
+static inline val_t *name##_get(struct name *t, key_t key) \
+{ \
+	tbl_size_t pos = _##name##_slot(t, key, _##name##_hash(key)); \
+	return t->a[pos].hash ? &t->a[pos].val : NULL; \
+} \
+\
+static inline int name##_remove(struct name *t, key_t key, val_t *val) \
+{ \
+	tbl_size_t pos = _##name##_slot(t, key, _##name##_hash(key)), next; \
+	if (!t->a[pos].hash) \
+		return -1; \
+	if (val) \
+		*val = t->a[pos].val; \
+	for (next = (pos + 1) & t->hashmask; t->a[next].hash; next = (next + 1) & t->hashmask){ \
+		if (_tbl_shift(t->a[next].hash & t->hashmask, pos, next, t->hashmask)){ \
+			t->a[pos] = t->a[next]; \
+			pos = next; \
+		} \
+	} \
+	t->a[pos].hash = 0; \
+	t->n--; \
+	if (t->n < t->shrink_at && t->max_lg2 > TBL_DEFAULT_SIZE_LG2) \
+		_##name##_resize(t, t->max_lg2 - 1); \
+	return 0; \
+} \
+\
+static inline void name##_free(struct name *t) \
+{ \
+	free(t->a); \
+	free(t); \
+	return; \
+}
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif /* tbl.h */
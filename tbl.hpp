@@ -0,0 +1,301 @@
+/* tbl: Dynamic hash table
+ * -----------------------
+ * Copyright (c) 2024 Vakaris Girnius <vakaris@girnius.dev>
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the authors be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef TBL_HPP
+#define TBL_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "tbl.h"
+
+/* C++17 wrapper around struct tbl. Build it with the same TBL_* macros as
+ * tbl.c: the engine, the hash and the key width are fixed when tbl.c is
+ * compiled, and the wrapper only chooses how keys are presented. */
+namespace tblpp{
+
+/* Key policies. type is what lookups take, bytes() gives the bytes tbl
+ * hashes and compares, and prefix() gives the key length at the start of
+ * a stored object for insert(T *). bytes_in_key is true when bytes()
+ * points into the key object itself, so it cannot be a temporary. */
+struct string_key{
+	using type = std::string_view;
+	static constexpr bool bytes_in_key = false;
+
+	static std::string_view bytes(std::string_view k) noexcept
+	{
+		return k;
+	}
+
+	template <class T>
+	static std::size_t prefix(const T *v) noexcept
+	{
+		return std::strlen(reinterpret_cast<const char *>(v));
+	}
+};
+
+/* Any trivially copyable key, such as an integer or a UUID struct, taken
+ * as its object bytes. Stored objects must begin with their K. */
+template <class K>
+struct pod_key{
+	using type = K;
+	static constexpr bool bytes_in_key = true;
+
+	static std::string_view bytes(const K &k) noexcept
+	{
+		return std::string_view(reinterpret_cast<const char *>(&k), sizeof(K));
+	}
+
+	template <class T>
+	static std::size_t prefix(const T *) noexcept
+	{
+		return sizeof(K);
+	}
+};
+
+/* Owns a struct tbl of T pointers. Lookups pass the key bytes straight to
+ * tbl_get_n, so a std::string_view, std::string or string literal is
+ * looked up without a temporary. Any put, get or remove invalidates
+ * iterators, since tbl may resize or migrate on each of them. For the
+ * same reason find() and contains() are not const, and concurrent lookups
+ * need outside locking under TBL_INCREMENTAL. A moved from table may only
+ * be assigned to or destroyed. */
+template <class T, class Key = string_key>
+class table{
+public:
+	using key_type = typename Key::type;
+
+	struct entry{
+		std::string_view key;
+		T *value;
+	};
+
+	class iterator{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = entry;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const entry *;
+		using reference = const entry &;
+
+		iterator() noexcept = default;
+
+		reference operator*() const noexcept
+		{
+			return e;
+		}
+
+		pointer operator->() const noexcept
+		{
+			return &e;
+		}
+
+		iterator &operator++() noexcept
+		{
+			pos++;
+			settle();
+			return *this;
+		}
+
+		iterator operator++(int) noexcept
+		{
+			iterator i = *this;
+			++*this;
+			return i;
+		}
+
+		bool operator==(const iterator &o) const noexcept
+		{
+			return t == o.t && pos == o.pos;
+		}
+
+		bool operator!=(const iterator &o) const noexcept
+		{
+			return !(*this == o);
+		}
+
+	private:
+		friend class table;
+
+		explicit iterator(struct tbl *t) noexcept : t(t)
+		{
+			settle();
+		}
+
+		/* Stop at the next live bucket, moving on to the table still
+		 * being migrated once the current one runs out. */
+		void settle() noexcept
+		{
+			while (t){
+				for (; pos != t->max; pos++){
+					const struct tbl_bkt &b = t->a[pos];
+					if (b.value){
+						e.key = std::string_view(static_cast<const char *>(b.value), b.len);
+#ifdef TBL_MAP
+						e.value = static_cast<T *>(b.data);
+#else
+						e.value = static_cast<T *>(b.value);
+#endif
+						return;
+					}
+				}
+#ifdef TBL_INCREMENTAL
+				t = t->old;
+#else
+				t = nullptr;
+#endif
+				pos = 0;
+			}
+			return;
+		}
+
+		struct tbl *t = nullptr;
+		tbl_size_t pos = 0;
+		entry e = {};
+	};
+
+	table() : t(tbl_create())
+	{
+		if (!t)
+			throw std::bad_alloc();
+	}
+
+	explicit table(tbl_size_t n) : t(tbl_create_with_capacity(n))
+	{
+		if (!t)
+			throw std::bad_alloc();
+	}
+
+	table(const table &) = delete;
+	table &operator=(const table &) = delete;
+
+	table(table &&o) noexcept : t(std::exchange(o.t, nullptr))
+	{
+	}
+
+	table &operator=(table &&o) noexcept
+	{
+		std::swap(t, o.t);
+		return *this;
+	}
+
+	~table()
+	{
+		if (t)
+			tbl_free(t);
+	}
+
+	/* Key is the first Key::prefix(value) bytes of *value. */
+	bool insert(T *value)
+	{
+		return !tbl_put_n(t, value, Key::prefix(value));
+	}
+
+#ifdef TBL_MAP
+	/* The key bytes are not copied and must outlive the entry. */
+	bool insert(const key_type &key, T *value)
+	{
+		std::string_view k = Key::bytes(key);
+		return !tbl_put_kv_n(t, k.data(), k.size(), value);
+	}
+
+	/* The table would keep the address of a temporary: with pod_key any
+	 * key_type rvalue, and with string_key an rvalue that owns its bytes,
+	 * such as a std::string. Literals, pointers and string_views view
+	 * storage outside the call and are still taken. */
+	template <class K = Key, std::enable_if_t<K::bytes_in_key, int> = 0>
+	bool insert(key_type &&key, T *value) = delete;
+
+	template <class S, class K = Key, std::enable_if_t<!K::bytes_in_key && !std::is_reference<S>::value
+			&& std::is_class<S>::value && !std::is_same<S, std::string_view>::value, int> = 0>
+	bool insert(S &&key, T *value) = delete;
+#endif
+
+	T *find(const key_type &key)
+	{
+		std::string_view k = Key::bytes(key);
+		return static_cast<T *>(tbl_get_n(t, k.data(), k.size()));
+	}
+
+	bool contains(const key_type &key)
+	{
+		return find(key) != nullptr;
+	}
+
+	T *erase(const key_type &key)
+	{
+		std::string_view k = Key::bytes(key);
+		return static_cast<T *>(tbl_remove_n(t, k.data(), k.size()));
+	}
+
+	bool reserve(tbl_size_t n)
+	{
+		return !tbl_reserve(t, n);
+	}
+
+	bool shrink_to_fit()
+	{
+		return !tbl_shrink_to_fit(t);
+	}
+
+	std::size_t size() const noexcept
+	{
+		std::size_t n = t->n;
+#ifdef TBL_INCREMENTAL
+		if (t->old)
+			n += t->old->n;
+#endif
+		return n;
+	}
+
+	bool empty() const noexcept
+	{
+		return !size();
+	}
+
+	iterator begin() const noexcept
+	{
+		return iterator(t);
+	}
+
+	iterator end() const noexcept
+	{
+		return iterator();
+	}
+
+	/* The underlying table, for calls into the C API. */
+	struct tbl *get() const noexcept
+	{
+		return t;
+	}
+
+private:
+	struct tbl *t;
+};
+
+} /* namespace tblpp */
+
+#endif /* tbl.hpp */
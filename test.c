@@ -1,6 +1,36 @@
 #include "tbl.h"
- 
+
+/* tbl_put does not dedupe, so one key may be stored many times. Cuckoo
+ * and hopscotch run out of room for a single hash and refuse further puts,
+ * but no engine may keep growing the table trying to fit them, also when
+ * shrinking is turned off. */
+static int _repeated_key(const struct tbl_policy *p)
+{
+	static char key[32] = "same";
+	struct tbl *t = tbl_create();
+	int ok = 0;
+
+	if (!t)
+		return -1;
+	if (p && tbl_set_policy(t, p)){
+		tbl_free(t);
+		return -1;
+	}
+	for (int i=0; i != 64; i++)
+		ok += !tbl_put(t, key);
+	if (ok < 4 || t->max > 1024 || tbl_get(t, key) != key){
+		tbl_free(t);
+		return -1;
+	}
+	tbl_free(t);
+	return 0;
+}
+
 int main(void)
 {
+	struct tbl_policy noshrink = {TBL_MAX_LOAD, 0, 1};
+
+	if (_repeated_key(NULL) || _repeated_key(&noshrink))
+		return 1;
 	return 0;
 }